@@ -9,6 +9,7 @@
 #include <mc/src/common/locale/I18n.hpp>
 #include "../../client/util/TextureUtil.hpp"
 #include <amethyst/runtime/utility/InlineHook.hpp>
+#include <mutex>
 
 namespace ForgeCraft {
 	class ToolHandle : public Item {
@@ -23,16 +24,34 @@ namespace ForgeCraft {
 	SafetyHookInline _TextureAtlas_addRuntimeImageGenerator;
 
 	std::vector<std::shared_ptr<RuntimeImageGeneratorInfo>> generators;
+
+	// Registry version shared by item registration and icon generation.
+	// Pinned once by whichever runs first, which also freezes the MaterialManager:
+	// add-ons have to register their materials before ForgeCraft registers its items.
+	std::once_flag materialsPinnedFlag;
+	std::shared_ptr<const ForgeCraft::MaterialRegistrySnapshot> materialsPinned;
+
+	std::shared_ptr<const ForgeCraft::MaterialRegistrySnapshot> getPinnedMaterials() {
+		std::call_once(materialsPinnedFlag, [] {
+			materialsPinned = ForgeCraft::MaterialManager::getInstance().freeze();
+		});
+		return materialsPinned;
+	}
+
 	void TextureAtlas_addRuntimeImageGenerator(TextureAtlas* self, std::weak_ptr<RuntimeImageGeneratorInfo> info) {
 		// Add texture generators
 		if (!hasAddedOwnGenerators) {
 			hasAddedOwnGenerators = true;
-			auto& matManager = ForgeCraft::MaterialManager::getInstance();
+			auto registry = getPinnedMaterials();
+			auto latestVersion = ForgeCraft::MaterialManager::getInstance().snapshot()->version;
+			if (registry->version != latestVersion) {
+				Log::Warning("Material registry changed after items were registered (v{} pinned, v{} latest), new materials have no items or icons", registry->version, latestVersion);
+			}
 
 			// Loop through all possible materials
-			for (const auto& [matId, material] : matManager.materials) {
+			for (const auto& [matId, material] : registry->materials) {
 				// Loop through all parts
-				for (const auto& [partId, part] : matManager.parts) {
+				for (const auto& [partId, part] : registry->parts) {
 					generators.push_back(std::make_shared<RuntimeImageGeneratorInfo>(
 						std::format("forgecraft:part_{}_{}", partId, matId),
 						ResourceLocation(std::format("textures/items/{}_{}", partId, matId)),
@@ -50,30 +69,29 @@ namespace ForgeCraft {
 			}
 
 			// Create finished tool textures
-			for (const auto& [toolId, tool] : matManager.tools) {
-				auto perms = matManager.getAllPermutationsFor(tool);
+			for (const auto& [toolId, tool] : registry->tools) {
+				auto perms = registry->getAllPermutationsFor(toolId);
 				for (const auto& perm : perms) {
 					std::string iconId = std::format("forgecraft:tool_{}", perm.permutationId);
 					generators.push_back(std::make_shared<RuntimeImageGeneratorInfo>(
 						iconId,
 						ResourceLocation(std::format("textures/items/tool_{}", perm.permutationId)),
-						[toolId, tool, &matManager, perm](AbstractTextureAccessor& accessor, cg::ImageBuffer& image) {
+						[perm](AbstractTextureAccessor& accessor, cg::ImageBuffer& image) {
 							std::vector<cg::ImageBuffer> partImages;
 
 							for (const auto& partData : perm.partMaterials) {
 								// Get part images
-								auto loc = ResourceLocation(partData.first.partIcon);
+								auto loc = ResourceLocation(partData.first->partIcon);
 								auto& img_handle = accessor.getCachedImageOrLoadSync(loc, true);
 
-								// Palette swap each part based on material
-								auto& material = partData.second;
-								auto& part = partData.first;
-								img_handle = TextureUtil::paletteSwap(
+								// Palette swap each part based on material, without touching the shared cached image
+								auto& material = *partData.second;
+								auto& part = *partData.first;
+								partImages.push_back(TextureUtil::paletteSwap(
 									img_handle,
 									part.palleteColors,
 									material.palleteColors
-								);
-								partImages.push_back(img_handle);
+								));
 							}
 
 							// Combine part images into final tool image
@@ -94,7 +112,7 @@ namespace ForgeCraft {
 
 	void ModItems::RegisterItems(RegisterItemsEvent& ev)
 	{
-		auto& matManager = ForgeCraft::MaterialManager::getInstance();
+		auto registry = getPinnedMaterials();
 
 		auto& i18n = getI18n();
 		std::unordered_map<std::string, std::string> additionalTranslations = {
@@ -102,8 +120,8 @@ namespace ForgeCraft {
 		};
 		i18n.appendAdditionalTranslations(additionalTranslations, "en-us");
 
-		for (const auto& [matId, material] : matManager.materials) {
-			for (const auto& [partId, part] : matManager.parts) {
+		for (const auto& [matId, material] : registry->materials) {
+			for (const auto& [partId, part] : registry->parts) {
 				auto id = std::format("forgecraft:part_{}_{}", partId, matId);
 				auto& item = *ev.itemRegistry.registerItemShared<ToolHandle>(id, ev.itemRegistry.getNextItemID());
 				item.setIconInfo(id, 0);
@@ -111,8 +129,8 @@ namespace ForgeCraft {
 			}
 		}
 
-		for (const auto& [toolId, tool] : matManager.tools) {
-			auto perms = matManager.getAllPermutationsFor(tool);
+		for (const auto& [toolId, tool] : registry->tools) {
+			auto perms = registry->getAllPermutationsFor(toolId);
 			for (const auto& perm : perms) {
 				auto id = std::format("forgecraft:tool_{}", perm.permutationId);
 				auto& item = *ev.itemRegistry.registerItemShared<ToolHandle>(id, ev.itemRegistry.getNextItemID());
@@ -1,5 +1,10 @@
 #pragma once
 #include <cstdint>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
 
 namespace ForgeCraft {
 	struct MaterialData {
@@ -15,9 +20,14 @@ namespace ForgeCraft {
 		const std::string partObject;
 	};
 
+	struct MaterialRegistrySnapshot;
+
 	struct PermutationData {
 		const std::string permutationId;
-		const std::vector<std::pair<PartData&, MaterialData&>> partMaterials;
+		const std::vector<std::pair<const PartData*, const MaterialData*>> partMaterials;
+
+		// Owns the parts and materials above, so they stay valid after newer versions are published
+		const std::shared_ptr<const MaterialRegistrySnapshot> snapshot;
 	};
 
 	struct ToolData {
@@ -26,44 +36,281 @@ namespace ForgeCraft {
 	};
 
 	/// <summary>
-	/// Singleton for getting and registering custom materials
+	/// Mutable copy of the registry that writers fill in before it is published as a new snapshot
 	/// </summary>
-	class MaterialManager {
-	public:
+	struct MaterialRegistryBatch {
 		std::map<std::string, MaterialData> materials;
 		std::map<std::string, PartData> parts;
 		std::map<std::string, ToolData> tools;
 
+		bool registerMaterial(const MaterialData& material) {
+			// Register a new material
+			auto result = materials.emplace(material.materialId, material);
+			return result.second; // true if inserted, false if already existed
+		}
+		bool registerPart(const PartData& part) {
+			// Register a new part data
+			auto result = parts.emplace(part.partId, part);
+			return result.second; // true if inserted, false if already existed
+		}
+		bool registerTool(const ToolData& tool) {
+			// Register a new tool data
+			auto result = tools.emplace(tool.toolId, tool);
+			return result.second; // true if inserted, false if already existed
+		}
+
+		void unregisterMaterials() {
+			materials.clear();
+		}
+	};
+
+	class MaterialManager;
+
+	/// <summary>
+	/// Immutable version of the registry, safe to read from any thread.
+	/// Only MaterialManager can create one, so it is always owned by a shared_ptr.
+	/// </summary>
+	struct MaterialRegistrySnapshot : std::enable_shared_from_this<MaterialRegistrySnapshot> {
+	private:
+		friend class MaterialManager;
+		struct ConstructToken {
+			explicit ConstructToken() = default;
+		};
+
+	public:
+		const uint64_t version;
+		const std::map<std::string, MaterialData> materials;
+		const std::map<std::string, PartData> parts;
+		const std::map<std::string, ToolData> tools;
+
+		MaterialRegistrySnapshot(ConstructToken, uint64_t version, MaterialRegistryBatch&& batch)
+			: version(version),
+			materials(std::move(batch.materials)),
+			parts(std::move(batch.parts)),
+			tools(std::move(batch.tools)) {
+		}
+
+		// Copies would not be owned by a shared_ptr, which getAllPermutationsFor relies on
+		MaterialRegistrySnapshot(const MaterialRegistrySnapshot&) = delete;
+		MaterialRegistrySnapshot& operator=(const MaterialRegistrySnapshot&) = delete;
+
+		const MaterialData* getMaterialData(const std::string& materialId) const {
+			// Get material data by ID
+			auto it = materials.find(materialId);
+			if (it != materials.end()) {
+				return &it->second;
+			}
+			return nullptr;
+		}
+
+		/// <summary>
+		/// Builds every material combination for a tool registered in this snapshot.
+		/// Throws std::out_of_range if the tool is not part of this version.
+		/// </summary>
+		std::vector<PermutationData> getAllPermutationsFor(const std::string& toolId) const {
+			const ToolData& tool = tools.at(toolId);
+			std::shared_ptr<const MaterialRegistrySnapshot> self = shared_from_this();
+
+			Log::Info("Generating permutations for {} (registry v{})", tool.toolId, version);
+			std::vector<PermutationData> permutations;
+
+			// build once: deterministic list of material pointers
+			std::vector<const MaterialData*> materialPtrs;
+			materialPtrs.reserve(materials.size());
+			for (auto const& kv : materials) {
+				materialPtrs.push_back(&kv.second);
+			}
+
+			Log::Info("Starting generation for {}", tool.toolId);
+			// working state: chosen material index for each part
+			std::vector<size_t> chosen(tool.parts.size(), 0);
+
+			// helper to build permutation id from pointers
+			auto buildId = [&](const std::vector<std::pair<const PartData*, const MaterialData*>>& refs) {
+				std::ostringstream id;
+				id << tool.toolId;
+				for (auto& pr : refs) id << '_' << pr.second->materialId;
+				return id.str();
+				};
+
+			// recursion
+			std::function<void(size_t)> generate = [&](size_t partIndex) {
+				Log::Info("[Permutation] {}", partIndex);
+				if (partIndex == tool.parts.size()) {
+					// convert chosen indices to pointer pairs
+					std::vector<std::pair<const PartData*, const MaterialData*>> refs;
+					refs.reserve(tool.parts.size());
+					for (size_t i = 0; i < tool.parts.size(); ++i) {
+						refs.emplace_back(&tool.parts[i], materialPtrs[chosen[i]]);
+					}
+
+					// push permutation
+					std::string id = buildId(refs);
+					permutations.emplace_back(PermutationData{ std::move(id), std::move(refs), self });
+					return;
+				}
+
+				for (size_t mi = 0; mi < materialPtrs.size(); ++mi) {
+					chosen[partIndex] = mi;
+					generate(partIndex + 1);
+				}
+			};
+
+			generate(0);
+			return permutations;
+		}
+	};
+
+	/// <summary>
+	/// Singleton for getting and registering custom materials.
+	/// Readers grab the current snapshot without ever waiting on the writer mutex,
+	/// writers are serialized and publish one new version per batch.
+	/// </summary>
+	class MaterialManager {
+	public:
 		static MaterialManager& getInstance() {
 			static MaterialManager instance;
 			return instance;
 		}
 
-		MaterialManager() {
-			registerMaterials();
-			registerParts();
+		MaterialManager()
+			: current(std::make_shared<const MaterialRegistrySnapshot>(MaterialRegistrySnapshot::ConstructToken{}, 0, MaterialRegistryBatch{})) {
+			update([](MaterialRegistryBatch& batch) {
+				registerMaterials(batch);
+				registerParts(batch);
 
-			registerTool(ToolData{
-				"pickaxe", std::vector<PartData>{
-					parts.at("tool_handle"),
-					parts.at("pickaxe_head")
-				} });
+				batch.registerTool(ToolData{
+					"pickaxe", std::vector<PartData>{
+						batch.parts.at("tool_handle"),
+						batch.parts.at("pickaxe_head")
+					} });
+			});
 
-			auto& tool = tools.at("pickaxe");
-			for (auto& val : getAllPermutationsFor(tool)) {
+			for (auto& val : snapshot()->getAllPermutationsFor("pickaxe")) {
 				Log::Info("Perm: {}", val.permutationId);
 			}
 		}
 
-		void registerParts() {
-			registerPart(PartData("tool_handle", std::vector<uint32_t>{
+		MaterialManager(const MaterialManager&) = delete;
+		MaterialManager& operator=(const MaterialManager&) = delete;
+
+		/// <summary>
+		/// Returns the latest published registry, its contents never change afterwards.
+		/// std::atomic<std::shared_ptr> is not lock-free: the load holds a short internal lock for the reference count
+		/// bump, but never waits on writers building a new version.
+		/// </summary>
+		std::shared_ptr<const MaterialRegistrySnapshot> snapshot() const {
+			return current.load(std::memory_order_acquire);
+		}
+
+		/// <summary>
+		/// Runs fn on a copy of the latest registry and publishes the result as a single new version.
+		/// Returns the published version number.
+		/// fn may only modify the batch it receives, calling back into the manager from fn throws std::logic_error.
+		/// Throws std::logic_error once the registry is frozen.
+		/// </summary>
+		template <typename Fn>
+		uint64_t update(Fn&& fn) {
+			auto version = publish(std::forward<Fn>(fn));
+			if (!version) {
+				throw std::logic_error("MaterialManager::update called after the registry was frozen");
+			}
+			return *version;
+		}
+
+		/// <summary>
+		/// Ends the registration window and returns the final snapshot.
+		/// Items and icons are created from this version, so any later change is rejected.
+		/// </summary>
+		std::shared_ptr<const MaterialRegistrySnapshot> freeze() {
+			std::lock_guard<std::mutex> lock(writeMutex);
+			frozen.store(true, std::memory_order_release);
+			return current.load(std::memory_order_acquire);
+		}
+
+		bool isFrozen() const {
+			return frozen.load(std::memory_order_acquire);
+		}
+
+		// The single-entry helpers below each copy the whole registry and publish a new version,
+		// use update() when registering more than one entry at once.
+		// They return false instead of throwing once the registry is frozen.
+
+		/// <summary>
+		/// Registers one material as its own version, prefer update() for bulk registration
+		/// </summary>
+		bool registerMaterial(const MaterialData& material) {
+			bool inserted = false;
+			bool published = publish([&](MaterialRegistryBatch& batch) { inserted = batch.registerMaterial(material); }).has_value();
+			return published && inserted;
+		}
+		/// <summary>
+		/// Registers one part as its own version, prefer update() for bulk registration
+		/// </summary>
+		bool registerPart(const PartData& part) {
+			bool inserted = false;
+			bool published = publish([&](MaterialRegistryBatch& batch) { inserted = batch.registerPart(part); }).has_value();
+			return published && inserted;
+		}
+		/// <summary>
+		/// Registers one tool as its own version, prefer update() for bulk registration
+		/// </summary>
+		bool registerTool(const ToolData& tool) {
+			bool inserted = false;
+			bool published = publish([&](MaterialRegistryBatch& batch) { inserted = batch.registerTool(tool); }).has_value();
+			return published && inserted;
+		}
+
+		void unregisterMaterials() {
+			publish([](MaterialRegistryBatch& batch) { batch.unregisterMaterials(); });
+		}
+
+	private:
+		// Returns the published version, or nothing if the registry is frozen
+		template <typename Fn>
+		std::optional<uint64_t> publish(Fn&& fn) {
+			if (isUpdating) {
+				throw std::logic_error("MaterialManager::update called from inside an update callback");
+			}
+
+			std::lock_guard<std::mutex> lock(writeMutex);
+			if (frozen.load(std::memory_order_relaxed)) {
+				Log::Warning("Material registry is frozen, registration after ForgeCraft registered its items is ignored");
+				return std::nullopt;
+			}
+
+			UpdateGuard guard;
+			auto previous = current.load(std::memory_order_acquire);
+
+			MaterialRegistryBatch batch{ previous->materials, previous->parts, previous->tools };
+			fn(batch);
+
+			uint64_t version = previous->version + 1;
+			current.store(std::make_shared<const MaterialRegistrySnapshot>(MaterialRegistrySnapshot::ConstructToken{}, version, std::move(batch)), std::memory_order_release);
+			return version;
+		}
+
+		std::atomic<std::shared_ptr<const MaterialRegistrySnapshot>> current;
+		std::mutex writeMutex;
+		std::atomic<bool> frozen{ false };
+
+		// Set while the current thread is inside update(), catches re-entry before it deadlocks on writeMutex
+		static inline thread_local bool isUpdating = false;
+
+		struct UpdateGuard {
+			UpdateGuard() { isUpdating = true; }
+			~UpdateGuard() { isUpdating = false; }
+		};
+
+		static void registerParts(MaterialRegistryBatch& batch) {
+			batch.registerPart(PartData("tool_handle", std::vector<uint32_t>{
 				0x898989FFu,
 					0x686868FFu,
 					0x494949FFu,
 					0x282828FFu
 			}, "textures/items/tool_handle", "textures/items/tool_handle"));
 
-			registerPart(PartData("pickaxe_head", std::vector<uint32_t>{
+			batch.registerPart(PartData("pickaxe_head", std::vector<uint32_t>{
 				0xffffffFFu,
 					0xd8d8d8FFu,
 					0xc1c1c1FFu,
@@ -72,9 +319,9 @@ namespace ForgeCraft {
 			}, "textures/items/pickaxe_head", "textures/items/pickaxe_head"));
 		}
 
-		void registerMaterials() {
+		static void registerMaterials(MaterialRegistryBatch& batch) {
 			// Wooden
-			registerMaterial(MaterialData{
+			batch.registerMaterial(MaterialData{
 				"wooden", std::vector<uint32_t>{
 					0x896727FFu,
 					0x684e1eFFu,
@@ -83,7 +330,7 @@ namespace ForgeCraft {
 					0x281e0bFFu
 				} });
 			// Stone
-			registerMaterial(MaterialData{
+			batch.registerMaterial(MaterialData{
 				"stone", std::vector<uint32_t>{
 					0x898989FFu,
 					0x686868FFu,
@@ -92,7 +339,7 @@ namespace ForgeCraft {
 					0x282828FFu
 				} });
 			// Iron
-			registerMaterial(MaterialData{
+			batch.registerMaterial(MaterialData{
 				"iron", std::vector<uint32_t>{
 					0xffffffFFu,
 					0xdfdfdfFFu,
@@ -101,7 +348,7 @@ namespace ForgeCraft {
 					0x888888FFu
 				} });
 			// Gold
-			registerMaterial(MaterialData{
+			batch.registerMaterial(MaterialData{
 				"gold", std::vector<uint32_t>{
 					0xfdf55fFFu,
 					0xfad64aFFu,
@@ -110,7 +357,7 @@ namespace ForgeCraft {
 					0x752802FFu
 				} });
 			// Diamond
-			registerMaterial(MaterialData{
+			batch.registerMaterial(MaterialData{
 				"diamond", std::vector<uint32_t>{
 					0xa1fbe8FFu,
 					0x4aedd9FFu,
@@ -119,88 +366,5 @@ namespace ForgeCraft {
 					0x145e53FFu
 				} });
 		}
-
-		void unregisterMaterials() {
-			materials.clear();
-		}
-
-		const MaterialData* getMaterialData(const std::string& materialId) const {
-			// Get material data by ID
-			auto it = materials.find(materialId);
-			if (it != materials.end()) {
-				return &it->second;
-			}
-			return nullptr;
-		}
-
-		bool registerMaterial(const MaterialData& material) {
-			// Register a new material
-			auto result = materials.emplace(material.materialId, material);
-			return result.second; // true if inserted, false if already existed
-		}
-		bool registerPart(const PartData& part) {
-			// Register a new part data
-			auto result = parts.emplace(part.partId, part);
-			return result.second; // true if inserted, false if already existed
-		}
-		bool registerTool(const ToolData& tool) {
-			// Register a new tool data
-			auto result = tools.emplace(tool.toolId, tool);
-			return result.second; // true if inserted, false if already existed
-		}
-
-		std::vector<PermutationData> getAllPermutationsFor(std::string toolId) const {
-			return getAllPermutationsFor(tools.at(toolId));
-		}
-		std::vector<PermutationData> getAllPermutationsFor(const ToolData& tool) const {
-			Log::Info("Generating permutations for {}", tool.toolId);
-			std::vector<PermutationData> permutations;
-
-			// build once: deterministic list of material pointers
-			std::vector<MaterialData*> materialPtrs;
-			materialPtrs.reserve(materials.size());
-			for (auto const& kv : materials) {
-				materialPtrs.push_back(const_cast<MaterialData*>(&kv.second)); // if materials are non-const values, cast not needed
-			}
-
-			Log::Info("Starting generation for {}", tool.toolId);
-			// working state: chosen material index for each part
-			std::vector<size_t> chosen(tool.parts.size(), 0);
-
-			// helper to build permutation id from refs
-			auto buildId = [&](const std::vector<std::pair<PartData&, MaterialData&>>& refs) {
-				std::ostringstream id;
-				id << tool.toolId;
-				for (auto& pr : refs) id << '_' << pr.second.materialId;
-				return id.str();
-				};
-
-			// recursion
-			std::function<void(size_t)> generate = [&](size_t partIndex) {
-				Log::Info("[Permutation] {}", partIndex);
-				if (partIndex == tool.parts.size()) {
-					// convert chosen indices to reference pairs
-					std::vector<std::pair<PartData&, MaterialData&>> refs;
-					refs.reserve(tool.parts.size());
-					for (size_t i = 0; i < tool.parts.size(); ++i) {
-						PartData& partRef = const_cast<PartData&>(tool.parts[i]);
-						MaterialData& matRef = *materialPtrs[chosen[i]];        // O(1) lookup, safe reference
-						refs.emplace_back(partRef, matRef);
-					}
-
-					// push permutation
-					permutations.emplace_back(PermutationData{ buildId(refs), std::move(refs) });
-					return;
-				}
-
-				for (size_t mi = 0; mi < materials.size(); ++mi) {
-					chosen[partIndex] = mi;
-					generate(partIndex + 1);
-				}
-			};
-
-			generate(0);
-			return permutations;
-		}
 	};
-}
\ No newline at end of file
+}